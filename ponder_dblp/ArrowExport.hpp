@@ -0,0 +1,620 @@
+// Columnar tables that can be handed to Arrow consumers (DuckDB, pandas, pyarrow, ...) without depending
+// on the Arrow libraries: in process through the Arrow C data/stream interface, or on disk as Arrow IPC files.
+// See https://arrow.apache.org/docs/format/CDataInterface.html and https://arrow.apache.org/docs/format/Columnar.html
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ABI definitions copied from the Arrow C data/stream interface specification
+extern "C" {
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+	void (*release)(struct ArrowSchema*);
+	void* private_data;
+};
+
+struct ArrowArray {
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+	void (*release)(struct ArrowArray*);
+	void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+	int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+	int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+	const char* (*get_last_error)(struct ArrowArrayStream*);
+	void (*release)(struct ArrowArrayStream*);
+	void* private_data;
+};
+
+#endif // ARROW_C_STREAM_INTERFACE
+}
+
+struct ArrowField {
+	std::string name;
+	std::string format; // C data interface format string, supported: "C" (uint8), "S" (uint16), "I" (uint32), "u" (utf8)
+	bool nullable = false;
+};
+
+// A table built row by row. Rows are split into record batches of at most batchRows rows,
+// which also keeps the int32 string offsets of a batch from overflowing.
+class ArrowTable {
+public:
+	struct Column {
+		std::vector<uint8_t> validity; // empty as long as the column has no nulls
+		std::vector<int32_t> offsets; // utf8 only
+		std::vector<uint8_t> values;
+		int64_t nullCount = 0;
+	};
+	struct Batch {
+		int64_t length = 0;
+		std::vector<Column> columns;
+	};
+
+	ArrowTable(std::vector<ArrowField> fields, int64_t batchRows = 1 << 20) : fields_(std::move(fields)), batchRows_(batchRows) {
+		for (const auto& f : fields_) {
+			if (f.format != "C" && f.format != "S" && f.format != "I" && f.format != "u") {
+				throw std::invalid_argument("Unsupported Arrow format '" + f.format + "' for field " + f.name);
+			}
+		}
+		if (batchRows_ < 1) {
+			throw std::invalid_argument("batchRows must be positive");
+		}
+	}
+
+	void appendUInt8(uint8_t v) {
+		appendPrimitive(nextColumn("C"), &v, sizeof(v));
+	}
+	void appendUInt16(uint16_t v) {
+		appendPrimitive(nextColumn("S"), &v, sizeof(v));
+	}
+	void appendUInt32(uint32_t v) {
+		appendPrimitive(nextColumn("I"), &v, sizeof(v));
+	}
+	void appendString(const std::string& v) {
+		auto& c = nextColumn("u");
+		if (c.values.size() + v.size() > INT32_MAX) {
+			throw std::length_error("String data of a record batch exceeds 2 GiB, use smaller batches");
+		}
+		c.values.insert(c.values.end(), v.begin(), v.end());
+		c.offsets.push_back(static_cast<int32_t>(c.values.size()));
+		setValid(c, true);
+	}
+	void appendNull() {
+		if (cursor_ < fields_.size() && !fields_[cursor_].nullable) {
+			throw std::invalid_argument("Field " + fields_[cursor_].name + " is not nullable");
+		}
+		const std::string format = cursor_ < fields_.size() ? fields_[cursor_].format : "";
+		auto& c = nextColumn(format.c_str());
+		if (format == "u") {
+			c.offsets.push_back(static_cast<int32_t>(c.values.size()));
+		} else {
+			c.values.resize(c.values.size() + primitiveWidth(format), 0);
+		}
+		setValid(c, false);
+		++c.nullCount;
+	}
+	void endRow() {
+		if (cursor_ != fields_.size()) {
+			throw std::logic_error("Incomplete row: " + std::to_string(cursor_) + " of " + std::to_string(fields_.size()) + " columns");
+		}
+		++batches_.back().length;
+		++numRows_;
+		cursor_ = 0;
+	}
+
+	const std::vector<ArrowField>& getFields() const {
+		return fields_;
+	}
+	const std::vector<Batch>& getBatches() const {
+		return batches_;
+	}
+	int64_t getNumRows() const {
+		return numRows_;
+	}
+
+	static size_t primitiveWidth(const std::string& format) {
+		return format == "C" ? 1 : format == "S" ? 2 : format == "I" ? 4 : 0;
+	}
+
+private:
+	Column& nextColumn(const char* format) {
+		if (cursor_ >= fields_.size()) {
+			throw std::logic_error("Too many columns in row, call endRow() first");
+		}
+		if (fields_[cursor_].format != format) {
+			throw std::invalid_argument("Field " + fields_[cursor_].name + " has format '" + fields_[cursor_].format + "', not '" + format + "'");
+		}
+		if (cursor_ == 0 && (batches_.empty() || batches_.back().length == batchRows_)) {
+			Batch b;
+			b.columns.resize(fields_.size());
+			for (size_t i = 0; i < fields_.size(); ++i) {
+				if (fields_[i].format == "u") b.columns[i].offsets.push_back(0);
+			}
+			batches_.push_back(std::move(b));
+		}
+		return batches_.back().columns[cursor_++];
+	}
+
+	void appendPrimitive(Column& c, const void* v, size_t size) {
+		const auto* bytes = static_cast<const uint8_t*>(v);
+		c.values.insert(c.values.end(), bytes, bytes + size);
+		setValid(c, true);
+	}
+
+	void setValid(Column& c, bool valid) {
+		const int64_t row = batches_.back().length;
+		if (valid && c.validity.empty()) return;
+		if (c.validity.empty()) {
+			// first null in this batch, all previous rows were valid
+			c.validity.assign(static_cast<size_t>(row / 8 + 1), 0xff);
+		}
+		c.validity.resize(static_cast<size_t>(row / 8 + 1), 0xff);
+		if (valid) {
+			c.validity[row / 8] |= static_cast<uint8_t>(1 << (row % 8));
+		} else {
+			c.validity[row / 8] &= static_cast<uint8_t>(~(1 << (row % 8)));
+		}
+	}
+
+	std::vector<ArrowField> fields_;
+	int64_t batchRows_;
+	std::vector<Batch> batches_;
+	size_t cursor_ = 0;
+	int64_t numRows_ = 0;
+};
+
+namespace arrow_detail {
+	struct SchemaPrivate {
+		std::string format;
+		std::string name;
+		std::vector<ArrowSchema*> children;
+	};
+
+	inline void releaseSchema(ArrowSchema* schema) {
+		auto priv = static_cast<SchemaPrivate*>(schema->private_data);
+		for (ArrowSchema* child : priv->children) {
+			if (child->release) child->release(child);
+			delete child;
+		}
+		delete priv;
+		schema->release = nullptr;
+	}
+
+	inline void fillSchema(ArrowSchema* out, const std::string& format, const std::string& name, int64_t flags, std::vector<ArrowSchema*> children) {
+		auto priv = new SchemaPrivate{ format, name, std::move(children) };
+		out->format = priv->format.c_str();
+		out->name = priv->name.c_str();
+		out->metadata = nullptr;
+		out->flags = flags;
+		out->n_children = static_cast<int64_t>(priv->children.size());
+		out->children = priv->children.empty() ? nullptr : priv->children.data();
+		out->dictionary = nullptr;
+		out->release = releaseSchema;
+		out->private_data = priv;
+	}
+
+	// every exported array, including the column children, keeps the table alive on its own,
+	// since consumers may move children out of their parent
+	struct ArrayPrivate {
+		std::shared_ptr<const ArrowTable> table;
+		std::vector<const void*> buffers;
+		std::vector<ArrowArray*> children;
+	};
+
+	inline void releaseArray(ArrowArray* array) {
+		auto priv = static_cast<ArrayPrivate*>(array->private_data);
+		for (ArrowArray* child : priv->children) {
+			if (child->release) child->release(child);
+			delete child;
+		}
+		delete priv;
+		array->release = nullptr;
+	}
+
+	inline const void* bufferOrEmpty(const void* p) {
+		static const int64_t empty = 0;
+		return p ? p : &empty;
+	}
+
+	inline void fillArray(ArrowArray* out, std::shared_ptr<const ArrowTable> table, int64_t length, int64_t nullCount,
+		std::vector<const void*> buffers, std::vector<ArrowArray*> children) {
+		auto priv = new ArrayPrivate{ std::move(table), std::move(buffers), std::move(children) };
+		out->length = length;
+		out->null_count = nullCount;
+		out->offset = 0;
+		out->n_buffers = static_cast<int64_t>(priv->buffers.size());
+		out->n_children = static_cast<int64_t>(priv->children.size());
+		out->buffers = priv->buffers.data();
+		out->children = priv->children.empty() ? nullptr : priv->children.data();
+		out->dictionary = nullptr;
+		out->release = releaseArray;
+		out->private_data = priv;
+	}
+
+	struct StreamPrivate {
+		std::shared_ptr<const ArrowTable> table;
+		size_t nextBatch = 0;
+		std::string lastError;
+	};
+}
+
+// Exports the table schema as a struct type whose children are the columns.
+inline void exportArrowSchema(const ArrowTable& table, ArrowSchema* out) {
+	std::vector<ArrowSchema*> children;
+	for (const auto& f : table.getFields()) {
+		auto child = new ArrowSchema;
+		arrow_detail::fillSchema(child, f.format, f.name, f.nullable ? ARROW_FLAG_NULLABLE : 0, {});
+		children.push_back(child);
+	}
+	arrow_detail::fillSchema(out, "+s", "", 0, std::move(children));
+}
+
+// Exports one record batch as a struct array. The buffers point into the table, nothing is copied.
+inline void exportArrowBatch(const std::shared_ptr<const ArrowTable>& table, size_t batchIndex, ArrowArray* out) {
+	const auto& batch = table->getBatches().at(batchIndex);
+	std::vector<ArrowArray*> children;
+	for (size_t i = 0; i < batch.columns.size(); ++i) {
+		const auto& c = batch.columns[i];
+		std::vector<const void*> buffers{ c.validity.empty() ? nullptr : c.validity.data() };
+		if (table->getFields()[i].format == "u") {
+			buffers.push_back(c.offsets.data());
+		}
+		buffers.push_back(arrow_detail::bufferOrEmpty(c.values.data()));
+		auto child = new ArrowArray;
+		arrow_detail::fillArray(child, table, batch.length, c.nullCount, std::move(buffers), {});
+		children.push_back(child);
+	}
+	arrow_detail::fillArray(out, table, batch.length, 0, { nullptr }, std::move(children));
+}
+
+// Exports the whole table as a stream of record batches, e.g. for duckdb.from_arrow() or pyarrow.RecordBatchReader._import_from_c().
+inline void exportArrowStream(std::shared_ptr<const ArrowTable> table, ArrowArrayStream* out) {
+	out->get_schema = [](ArrowArrayStream* stream, ArrowSchema* schema) -> int {
+		auto priv = static_cast<arrow_detail::StreamPrivate*>(stream->private_data);
+		try {
+			exportArrowSchema(*priv->table, schema);
+			return 0;
+		} catch (const std::bad_alloc& e) {
+			priv->lastError = e.what();
+			return ENOMEM;
+		} catch (const std::exception& e) {
+			priv->lastError = e.what();
+			return EIO;
+		}
+	};
+	out->get_next = [](ArrowArrayStream* stream, ArrowArray* array) -> int {
+		auto priv = static_cast<arrow_detail::StreamPrivate*>(stream->private_data);
+		try {
+			if (priv->nextBatch < priv->table->getBatches().size()) {
+				exportArrowBatch(priv->table, priv->nextBatch++, array);
+			} else {
+				array->release = nullptr; // end of stream
+			}
+			return 0;
+		} catch (const std::bad_alloc& e) {
+			priv->lastError = e.what();
+			return ENOMEM;
+		} catch (const std::exception& e) {
+			priv->lastError = e.what();
+			return EIO;
+		}
+	};
+	out->get_last_error = [](ArrowArrayStream* stream) -> const char* {
+		auto priv = static_cast<arrow_detail::StreamPrivate*>(stream->private_data);
+		return priv->lastError.empty() ? nullptr : priv->lastError.c_str();
+	};
+	out->release = [](ArrowArrayStream* stream) {
+		delete static_cast<arrow_detail::StreamPrivate*>(stream->private_data);
+		stream->release = nullptr;
+	};
+	out->private_data = new arrow_detail::StreamPrivate{ std::move(table), 0, {} };
+}
+
+namespace arrow_detail {
+	// Minimal flatbuffer serializer for the IPC metadata. Unlike the reference builder it writes front to back:
+	// every table, vector and string is emitted after the slot referencing it, so all uoffsets are positive,
+	// and each vtable is placed directly in front of its table.
+	struct FbNode;
+	using FbNodePtr = std::shared_ptr<FbNode>;
+	struct FbNode {
+		enum Kind { Table, String, TableVector, StructVector } kind = Table;
+		struct Field {
+			uint16_t id;
+			std::vector<uint8_t> scalar; // used if child is empty
+			FbNodePtr child;
+		};
+		std::vector<Field> fields;
+		std::string str;
+		std::vector<FbNodePtr> items;
+		std::vector<uint8_t> structs;
+		uint32_t structCount = 0;
+		size_t structAlign = 1;
+
+		template <typename T>
+		FbNode& scalar(uint16_t id, T v) {
+			std::vector<uint8_t> bytes(sizeof(T));
+			std::memcpy(bytes.data(), &v, sizeof(T));
+			fields.push_back({ id, std::move(bytes), nullptr });
+			return *this;
+		}
+		FbNode& child(uint16_t id, FbNodePtr c) {
+			fields.push_back({ id, {}, std::move(c) });
+			return *this;
+		}
+	};
+
+	inline FbNodePtr fbTable() {
+		return std::make_shared<FbNode>();
+	}
+	inline FbNodePtr fbString(const std::string& s) {
+		auto n = std::make_shared<FbNode>();
+		n->kind = FbNode::String;
+		n->str = s;
+		return n;
+	}
+	inline FbNodePtr fbTables(std::vector<FbNodePtr> items) {
+		auto n = std::make_shared<FbNode>();
+		n->kind = FbNode::TableVector;
+		n->items = std::move(items);
+		return n;
+	}
+	inline FbNodePtr fbStructs(std::vector<uint8_t> bytes, uint32_t count, size_t align) {
+		auto n = std::make_shared<FbNode>();
+		n->kind = FbNode::StructVector;
+		n->structs = std::move(bytes);
+		n->structCount = count;
+		n->structAlign = align;
+		return n;
+	}
+
+	class FbWriter {
+	public:
+		std::vector<uint8_t> finish(const FbNode& root) {
+			buf_.assign(4, 0);
+			patch(0, write(root));
+			return std::move(buf_);
+		}
+
+	private:
+		// pads so that the position `ahead` bytes from now is aligned
+		void padFor(size_t align, size_t ahead = 0) {
+			while ((buf_.size() + ahead) % align) buf_.push_back(0);
+		}
+		template <typename T>
+		void put(T v) {
+			const auto* bytes = reinterpret_cast<const uint8_t*>(&v);
+			buf_.insert(buf_.end(), bytes, bytes + sizeof(T));
+		}
+		void patch(size_t slot, size_t target) {
+			uint32_t off = static_cast<uint32_t>(target - slot);
+			std::memcpy(buf_.data() + slot, &off, sizeof(off));
+		}
+
+		size_t write(const FbNode& n) {
+			size_t pos;
+			switch (n.kind) {
+			case FbNode::String:
+				padFor(4);
+				pos = buf_.size();
+				put(static_cast<uint32_t>(n.str.size()));
+				buf_.insert(buf_.end(), n.str.begin(), n.str.end());
+				buf_.push_back(0);
+				return pos;
+			case FbNode::StructVector:
+				padFor(std::max<size_t>(4, n.structAlign), 4);
+				pos = buf_.size();
+				put(n.structCount);
+				buf_.insert(buf_.end(), n.structs.begin(), n.structs.end());
+				return pos;
+			case FbNode::TableVector:
+				padFor(4);
+				pos = buf_.size();
+				put(static_cast<uint32_t>(n.items.size()));
+				buf_.resize(buf_.size() + 4 * n.items.size(), 0);
+				for (size_t i = 0; i < n.items.size(); ++i) {
+					patch(pos + 4 + 4 * i, write(*n.items[i]));
+				}
+				return pos;
+			default:
+				break;
+			}
+
+			// table: soffset to the vtable, then the fields by descending size so they pack without gaps
+			size_t numSlots = 0;
+			size_t tableAlign = 4;
+			std::vector<const FbNode::Field*> order;
+			for (const auto& f : n.fields) {
+				numSlots = std::max<size_t>(numSlots, f.id + 1);
+				tableAlign = std::max(tableAlign, f.child ? 4 : f.scalar.size());
+				order.push_back(&f);
+			}
+			auto size = [](const FbNode::Field* f) { return f->child ? size_t(4) : f->scalar.size(); };
+			std::stable_sort(order.begin(), order.end(), [&](auto l, auto r) { return size(l) > size(r); });
+			std::vector<uint16_t> vtable(numSlots, 0);
+			size_t tableSize = 4;
+			for (auto f : order) {
+				tableSize = (tableSize + size(f) - 1) / size(f) * size(f);
+				vtable[f->id] = static_cast<uint16_t>(tableSize);
+				tableSize += size(f);
+			}
+
+			const size_t vtableSize = 4 + 2 * numSlots;
+			padFor(tableAlign, vtableSize);
+			const size_t vtablePos = buf_.size();
+			put(static_cast<uint16_t>(vtableSize));
+			put(static_cast<uint16_t>(tableSize));
+			for (uint16_t o : vtable) put(o);
+			pos = buf_.size();
+			put(static_cast<int32_t>(pos - vtablePos));
+			buf_.resize(pos + tableSize, 0);
+			for (const auto& f : n.fields) {
+				if (!f.child) std::memcpy(buf_.data() + pos + vtable[f.id], f.scalar.data(), f.scalar.size());
+			}
+			for (const auto& f : n.fields) {
+				if (f.child) patch(pos + vtable[f.id], write(*f.child));
+			}
+			return pos;
+		}
+
+		std::vector<uint8_t> buf_;
+	};
+
+	// enum values from Schema.fbs and Message.fbs
+	constexpr int16_t MetadataV5 = 4;
+	constexpr uint8_t TypeInt = 2;
+	constexpr uint8_t TypeUtf8 = 5;
+	constexpr uint8_t HeaderSchema = 1;
+	constexpr uint8_t HeaderRecordBatch = 3;
+
+	inline FbNodePtr ipcSchema(const ArrowTable& table) {
+		std::vector<FbNodePtr> fields;
+		for (const auto& f : table.getFields()) {
+			auto field = fbTable();
+			field->child(0, fbString(f.name)).scalar<uint8_t>(1, f.nullable).child(5, fbTables({}));
+			if (f.format == "u") {
+				field->scalar(2, TypeUtf8).child(3, fbTable());
+			} else {
+				auto type = fbTable();
+				type->scalar<int32_t>(0, static_cast<int32_t>(8 * ArrowTable::primitiveWidth(f.format))).scalar<uint8_t>(1, 0);
+				field->scalar(2, TypeInt).child(3, type);
+			}
+			fields.push_back(field);
+		}
+		auto schema = fbTable();
+		schema->scalar<int16_t>(0, 0).child(1, fbTables(std::move(fields))); // little endian
+		return schema;
+	}
+
+	template <typename T>
+	void appendLE(std::vector<uint8_t>& out, T v) {
+		const auto* bytes = reinterpret_cast<const uint8_t*>(&v);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	struct IpcBlock {
+		int64_t offset;
+		int32_t metaDataLength;
+		int64_t bodyLength;
+	};
+
+	// writes continuation marker, metadata length, metadata and body; returns the block for the file footer
+	inline IpcBlock writeMessage(std::ofstream& out, const FbNode& message, const std::vector<std::pair<const void*, size_t>>& body, int64_t bodyLength) {
+		IpcBlock block{ static_cast<int64_t>(out.tellp()), 0, bodyLength };
+		auto meta = FbWriter().finish(message);
+		meta.resize((meta.size() + 8 + 7) / 8 * 8 - 8, 0);
+		const uint32_t continuation = 0xffffffff;
+		const int32_t metaLength = static_cast<int32_t>(meta.size());
+		out.write(reinterpret_cast<const char*>(&continuation), sizeof(continuation));
+		out.write(reinterpret_cast<const char*>(&metaLength), sizeof(metaLength));
+		out.write(reinterpret_cast<const char*>(meta.data()), meta.size());
+		block.metaDataLength = metaLength + 8;
+		static const char zeros[8] = {};
+		for (const auto& [data, size] : body) {
+			out.write(static_cast<const char*>(data), size);
+			out.write(zeros, (8 - size % 8) % 8);
+		}
+		return block;
+	}
+}
+
+// Writes the table as an Arrow IPC file (Feather v2), readable by pyarrow.ipc.open_file / pyarrow.memory_map
+// without parsing. Assumes a little-endian host, like the rest of ponder_dblp's binary output.
+inline void writeArrowIPCFile(const ArrowTable& table, const std::string& path) {
+	using namespace arrow_detail;
+	std::ofstream out(path, std::ios::binary);
+	if (!out) {
+		throw std::runtime_error("Failed to open " + path + " for writing");
+	}
+	out.write("ARROW1\0\0", 8);
+
+	auto schema = ipcSchema(table);
+	{
+		auto message = fbTable();
+		message->scalar(0, MetadataV5).scalar(1, HeaderSchema).child(2, schema).scalar<int64_t>(3, 0);
+		writeMessage(out, *message, {}, 0);
+	}
+
+	std::vector<uint8_t> blocks;
+	uint32_t numBlocks = 0;
+	for (const auto& batch : table.getBatches()) {
+		std::vector<uint8_t> nodes, buffers;
+		std::vector<std::pair<const void*, size_t>> body;
+		int64_t bodyLength = 0;
+		auto addBuffer = [&](const void* data, size_t size) {
+			appendLE<int64_t>(buffers, bodyLength);
+			appendLE<int64_t>(buffers, static_cast<int64_t>(size));
+			body.emplace_back(data, size);
+			bodyLength += (size + 7) / 8 * 8;
+		};
+		for (size_t i = 0; i < batch.columns.size(); ++i) {
+			const auto& c = batch.columns[i];
+			appendLE<int64_t>(nodes, batch.length);
+			appendLE<int64_t>(nodes, c.nullCount);
+			addBuffer(c.validity.data(), c.nullCount ? static_cast<size_t>((batch.length + 7) / 8) : 0);
+			if (table.getFields()[i].format == "u") {
+				addBuffer(c.offsets.data(), c.offsets.size() * sizeof(int32_t));
+			}
+			addBuffer(c.values.data(), c.values.size());
+		}
+		auto recordBatch = fbTable();
+		recordBatch->scalar<int64_t>(0, batch.length)
+			.child(1, fbStructs(std::move(nodes), static_cast<uint32_t>(batch.columns.size()), 8))
+			.child(2, fbStructs(std::move(buffers), static_cast<uint32_t>(body.size()), 8));
+		auto message = fbTable();
+		message->scalar(0, MetadataV5).scalar(1, HeaderRecordBatch).child(2, recordBatch).scalar<int64_t>(3, bodyLength);
+		auto block = writeMessage(out, *message, body, bodyLength);
+		appendLE<int64_t>(blocks, block.offset);
+		appendLE<int32_t>(blocks, block.metaDataLength);
+		appendLE<int32_t>(blocks, 0); // padding
+		appendLE<int64_t>(blocks, block.bodyLength);
+		++numBlocks;
+	}
+
+	// end-of-stream marker, then the footer
+	const uint32_t eos[2] = { 0xffffffff, 0 };
+	out.write(reinterpret_cast<const char*>(eos), sizeof(eos));
+	auto footer = fbTable();
+	footer->scalar(0, MetadataV5).child(1, schema).child(2, fbStructs({}, 0, 8)).child(3, fbStructs(std::move(blocks), numBlocks, 8));
+	auto footerBytes = FbWriter().finish(*footer);
+	const int32_t footerLength = static_cast<int32_t>(footerBytes.size());
+	out.write(reinterpret_cast<const char*>(footerBytes.data()), footerBytes.size());
+	out.write(reinterpret_cast<const char*>(&footerLength), sizeof(footerLength));
+	out.write("ARROW1", 6);
+	if (!out) {
+		throw std::runtime_error("Failed to write " + path);
+	}
+}
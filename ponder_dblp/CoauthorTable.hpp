@@ -0,0 +1,319 @@
+// Precomputed coauthor-pair table: for every author, the sorted list of coauthors together with
+// the first and last year of collaboration and the number of shared papers.
+//
+// File layout (host byte order, little-endian on all supported platforms):
+//   CoauthorTableHeader
+//   uint64_t offsets[numAuthors + 1]   byte offsets into the payload, author a spans [offsets[a], offsets[a + 1])
+//   uint8_t  payload[payloadSize]
+// Each author's entries are sorted by coauthor ID and stored as four varints:
+//   coauthor ID delta to the previous entry, lastYear - baseYear, lastYear - firstYear, paperCount - 1
+// The file can be memory-mapped as is and queried through CoauthorTableView.
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "InMemDB.hpp"
+#include "ThreadPool.hpp"
+
+struct CoauthorTableHeader {
+	char magic[4] = { 'Q', 'D', 'C', 'T' };
+	uint32_t version = 1;
+	uint32_t numAuthors = 0; // author IDs are in [0, numAuthors)
+	uint16_t baseYear = 0;
+	uint16_t reserved = 0;
+	uint64_t numEntries = 0; // directed entries, i.e. twice the number of coauthor pairs
+	uint64_t payloadSize = 0;
+};
+static_assert(sizeof(CoauthorTableHeader) == 32, "CoauthorTableHeader must not contain padding");
+
+struct CoauthorEntry {
+	uint32_t coauthor = 0;
+	uint16_t firstYear = 0;
+	uint16_t lastYear = 0;
+	uint32_t paperCount = 0;
+};
+
+namespace coauthor_detail {
+	inline void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+		while (v >= 0x80) {
+			out.push_back(static_cast<uint8_t>(v | 0x80));
+			v >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(v));
+	}
+
+	inline uint32_t getVarint(const uint8_t*& p, const uint8_t* end) {
+		uint32_t v = 0;
+		for (int shift = 0; p < end && shift < 35; shift += 7) {
+			uint8_t b = *p++;
+			// the fifth byte only has room for the top 4 bits of a uint32_t
+			if (shift == 28 && b > 0x0f) break;
+			v |= static_cast<uint32_t>(b & 0x7f) << shift;
+			if ((b & 0x80) == 0) return v;
+		}
+		throw std::runtime_error("Corrupt varint in coauthor table");
+	}
+
+	// one occurrence of a coauthor on a paper of the given year
+	struct Occurrence {
+		uint32_t coauthor;
+		uint16_t year;
+	};
+
+	// compressed sparse rows: the items of row r are items[start[r]] .. items[start[r + 1] - 1]
+	struct CSR {
+		std::vector<uint32_t> start;
+		std::vector<uint32_t> items;
+	};
+}
+
+class CoauthorTableBuilder {
+public:
+	// paperYears is indexed by paper ID, numAuthors is the largest author ID + 1
+	CoauthorTableBuilder(const LinkDB<uint32_t>& links, const std::vector<uint16_t>& paperYears, uint32_t numAuthors)
+		: links_(links), paperYears_(paperYears), numAuthors_(numAuthors) {}
+
+	// Parallel sort-and-reduce over contiguous author ranges (shards): for each author, the coauthor occurrences
+	// of all its papers are gathered, sorted and reduced, then varint-encoded. Only one author's occurrences are
+	// held per task at a time, so use more shards than threads to balance the load.
+	void build(ThreadPool& pool, size_t numShards) {
+		numShards = std::max<size_t>(1, std::min<size_t>(numShards, numAuthors_ ? numAuthors_ : 1));
+
+		for (const auto& [paper, author] : links_) {
+			if (paper >= paperYears_.size() || author >= numAuthors_) {
+				throw std::out_of_range("Link references unknown paper or author");
+			}
+		}
+		// an author may be linked to the same paper more than once, count each paper only once
+		auto paperAuthors = groupLinks(paperYears_.size(), false);
+		auto authorPapers = groupLinks(numAuthors_, true);
+
+		baseYear_ = UINT16_MAX;
+		for (uint16_t y : paperYears_) {
+			if (y != 0) baseYear_ = std::min(baseYear_, y);
+		}
+		if (baseYear_ == UINT16_MAX) baseYear_ = 0;
+
+		// each shard covers a contiguous author range, so the encoded shards concatenate in ID order
+		std::vector<std::vector<uint8_t>> shardPayloads(numShards);
+		std::vector<std::vector<uint64_t>> shardOffsets(numShards);
+		std::vector<uint64_t> shardEntries(numShards, 0);
+		for (size_t s = 0; s < numShards; ++s) {
+			pool.enqueue([&, s]() {
+				const uint32_t authorBegin = shardBegin(s, numShards);
+				const uint32_t authorEnd = shardBegin(s + 1, numShards);
+				auto& payload = shardPayloads[s];
+				auto& offsets = shardOffsets[s];
+				offsets.reserve(authorEnd - authorBegin);
+				std::vector<coauthor_detail::Occurrence> occ;
+				for (uint32_t a = authorBegin; a < authorEnd; ++a) {
+					offsets.push_back(payload.size());
+					occ.clear();
+					for (uint32_t i = authorPapers.start[a]; i < authorPapers.start[a + 1]; ++i) {
+						const uint32_t p = authorPapers.items[i];
+						if (paperYears_[p] == 0) continue;
+						for (uint32_t j = paperAuthors.start[p]; j < paperAuthors.start[p + 1]; ++j) {
+							if (paperAuthors.items[j] != a) occ.push_back({ paperAuthors.items[j], paperYears_[p] });
+						}
+					}
+					std::sort(occ.begin(), occ.end(), [](const auto& l, const auto& r) {
+						return std::tie(l.coauthor, l.year) < std::tie(r.coauthor, r.year);
+					});
+
+					uint32_t prev = 0;
+					for (size_t i = 0; i < occ.size();) {
+						const uint32_t coauthor = occ[i].coauthor;
+						const uint16_t firstYear = occ[i].year;
+						uint16_t lastYear = firstYear;
+						uint32_t count = 0;
+						for (; i < occ.size() && occ[i].coauthor == coauthor; ++i) {
+							lastYear = occ[i].year;
+							++count;
+						}
+						coauthor_detail::putVarint(payload, coauthor - prev);
+						coauthor_detail::putVarint(payload, lastYear - baseYear_);
+						coauthor_detail::putVarint(payload, lastYear - firstYear);
+						coauthor_detail::putVarint(payload, count - 1);
+						prev = coauthor;
+						++shardEntries[s];
+					}
+				}
+			});
+		}
+		pool.waitForAll();
+
+		offsets_.clear();
+		offsets_.reserve(static_cast<size_t>(numAuthors_) + 1);
+		payload_.clear();
+		numEntries_ = 0;
+		for (size_t s = 0; s < numShards; ++s) {
+			const uint64_t base = payload_.size();
+			for (uint64_t o : shardOffsets[s]) offsets_.push_back(base + o);
+			payload_.insert(payload_.end(), shardPayloads[s].begin(), shardPayloads[s].end());
+			shardPayloads[s] = {};
+			numEntries_ += shardEntries[s];
+		}
+		offsets_.push_back(payload_.size());
+	}
+
+	void write(const std::string& path) const {
+		std::ofstream out(path, std::ios::binary);
+		if (!out) {
+			throw std::runtime_error("Failed to open " + path + " for writing");
+		}
+		CoauthorTableHeader header;
+		header.numAuthors = numAuthors_;
+		header.baseYear = baseYear_;
+		header.numEntries = numEntries_;
+		header.payloadSize = payload_.size();
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(offsets_.data()), offsets_.size() * sizeof(uint64_t));
+		out.write(reinterpret_cast<const char*>(payload_.data()), payload_.size());
+		if (!out) {
+			throw std::runtime_error("Failed to write " + path);
+		}
+	}
+
+	uint64_t numPairs() const {
+		return numEntries_ / 2;
+	}
+
+private:
+	// shard s owns authors [shardBegin(s), shardBegin(s + 1))
+	uint32_t shardBegin(size_t s, size_t numShards) const {
+		return static_cast<uint32_t>(static_cast<uint64_t>(numAuthors_) * s / numShards);
+	}
+	// groups the links by paper (or by author), each row sorted and without duplicates
+	coauthor_detail::CSR groupLinks(size_t numRows, bool byAuthor) const {
+		coauthor_detail::CSR csr;
+		csr.start.assign(numRows + 1, 0);
+		for (const auto& link : links_) {
+			++csr.start[(byAuthor ? link.second : link.first) + 1];
+		}
+		for (size_t r = 1; r < csr.start.size(); ++r) {
+			csr.start[r] += csr.start[r - 1];
+		}
+		csr.items.resize(csr.start.back());
+		{
+			std::vector<uint32_t> fill(csr.start.begin(), csr.start.end() - 1);
+			for (const auto& link : links_) {
+				const uint32_t row = byAuthor ? link.second : link.first;
+				csr.items[fill[row]++] = byAuthor ? link.first : link.second;
+			}
+		}
+		// compact in place, rows only ever move towards the front
+		uint32_t write = 0;
+		uint32_t begin = 0;
+		for (size_t r = 0; r < numRows; ++r) {
+			const uint32_t end = csr.start[r + 1];
+			auto first = csr.items.begin() + begin;
+			std::sort(first, csr.items.begin() + end);
+			auto last = std::unique(first, csr.items.begin() + end);
+			csr.start[r] = write;
+			write = static_cast<uint32_t>(std::move(first, last, csr.items.begin() + write) - csr.items.begin());
+			begin = end;
+		}
+		csr.start.back() = write;
+		csr.items.resize(write);
+		return csr;
+	}
+
+	const LinkDB<uint32_t>& links_;
+	const std::vector<uint16_t>& paperYears_;
+	uint32_t numAuthors_;
+	uint16_t baseYear_ = 0;
+	uint64_t numEntries_ = 0;
+	std::vector<uint64_t> offsets_;
+	std::vector<uint8_t> payload_;
+};
+
+// Read-only view over a coauthor table file, e.g. a memory-mapped one. Does not own the data.
+class CoauthorTableView {
+public:
+	CoauthorTableView(const uint8_t* data, size_t size) {
+		if (size < sizeof(CoauthorTableHeader)) {
+			throw std::invalid_argument("Coauthor table too small");
+		}
+		std::memcpy(&header_, data, sizeof(header_));
+		if (std::memcmp(header_.magic, CoauthorTableHeader().magic, sizeof(header_.magic)) != 0 || header_.version != 1) {
+			throw std::invalid_argument("Not a coauthor table or unsupported version");
+		}
+		// compare by subtracting, a corrupt payloadSize must not wrap the sum
+		const uint64_t offsetsSize = (static_cast<uint64_t>(header_.numAuthors) + 1) * sizeof(uint64_t);
+		const uint64_t available = size - sizeof(CoauthorTableHeader);
+		if (available < offsetsSize || header_.payloadSize > available - offsetsSize) {
+			throw std::invalid_argument("Coauthor table truncated");
+		}
+		offsets_ = data + sizeof(CoauthorTableHeader);
+		payload_ = offsets_ + offsetsSize;
+	}
+
+	uint32_t numAuthors() const {
+		return header_.numAuthors;
+	}
+
+	uint64_t numPairs() const {
+		return header_.numEntries / 2;
+	}
+
+	// calls f(const CoauthorEntry&) for every coauthor of author, in ascending coauthor order
+	template <typename F>
+	void forEachCoauthor(uint32_t author, F&& f) const {
+		if (author >= header_.numAuthors) return;
+		const uint8_t* p = payload_ + offset(author);
+		const uint8_t* end = payload_ + offset(author + 1);
+		if (offset(author + 1) > header_.payloadSize || p > end) {
+			throw std::runtime_error("Corrupt offsets in coauthor table");
+		}
+		CoauthorEntry e;
+		uint32_t prev = 0;
+		while (p < end) {
+			e.coauthor = prev + coauthor_detail::getVarint(p, end);
+			e.lastYear = static_cast<uint16_t>(header_.baseYear + coauthor_detail::getVarint(p, end));
+			e.firstYear = static_cast<uint16_t>(e.lastYear - coauthor_detail::getVarint(p, end));
+			e.paperCount = coauthor_detail::getVarint(p, end) + 1;
+			prev = e.coauthor;
+			f(e);
+		}
+	}
+
+	std::vector<CoauthorEntry> getCoauthors(uint32_t author) const {
+		std::vector<CoauthorEntry> result;
+		forEachCoauthor(author, [&](const CoauthorEntry& e) { result.push_back(e); });
+		return result;
+	}
+
+	// Conflicts of author with a sorted list of candidate authors (e.g. a submission's authors),
+	// restricted to collaborations in minYear or later. Bounded merge of the two sorted lists.
+	std::vector<CoauthorEntry> findConflicts(uint32_t author, const std::vector<uint32_t>& sortedCandidates, uint16_t minYear) const {
+		std::vector<CoauthorEntry> result;
+		auto c = sortedCandidates.begin();
+		forEachCoauthor(author, [&](const CoauthorEntry& e) {
+			c = std::lower_bound(c, sortedCandidates.end(), e.coauthor);
+			if (c != sortedCandidates.end() && *c == e.coauthor && e.lastYear >= minYear) {
+				result.push_back(e);
+			}
+		});
+		return result;
+	}
+
+private:
+	uint64_t offset(uint32_t author) const {
+		uint64_t o;
+		std::memcpy(&o, offsets_ + static_cast<size_t>(author) * sizeof(uint64_t), sizeof(o));
+		return o;
+	}
+
+	CoauthorTableHeader header_;
+	const uint8_t* offsets_ = nullptr;
+	const uint8_t* payload_ = nullptr;
+};
@@ -21,6 +21,8 @@
 
 #include <pugixml.hpp>
 
+#include "ArrowExport.hpp"
+#include "CoauthorTable.hpp"
 #include "InMemDB.hpp"
 #include "ThreadPool.hpp"
 #include "ThreadSafeIDGenerator.hpp"
@@ -321,7 +323,7 @@ void dumpData(const std::string& inputFilePath) {
 	papersAuthorsFile << "PaperID\tAuthorID\n";
 
 	std::cout << "Dumping papers..." << std::endl;
-	for (auto p = 1; p < papersToNumbers.getMaxID(); ++p) {
+	for (uint32_t p = 1; p <= papersToNumbers.getMaxID(); ++p) {
 		if (p % 100000 == 0) {
 			checkProgress(p, papersToNumbers.getMaxID());
 		}
@@ -329,7 +331,7 @@ void dumpData(const std::string& inputFilePath) {
 		papersFile << p << "\t" << paper.id << "\t" << paper.title << "\t" << unsigned(paper.type) << "\t" << paper.year << "\n";
 	}
 	std::cout << std::endl << "Dumping authors..." << std::endl;
-	for (auto a = 1; a < authorsToNumbers.getMaxID(); ++a) {
+	for (uint32_t a = 1; a <= authorsToNumbers.getMaxID(); ++a) {
 		if (a % 100000 == 0) {
 			checkProgress(a, authorsToNumbers.getMaxID());
 		}
@@ -337,7 +339,7 @@ void dumpData(const std::string& inputFilePath) {
 		authorsFile << a << "\t" << author.id << "\t" << author.name << "\t" << author.orcid << "\n";
 	}
 	std::cout << std::endl << "Dumping relations..." << std::endl;
-	for (auto r = 1; r < papersAndAuthorsDB.size(); ++r) {
+	for (size_t r = 0; r < papersAndAuthorsDB.size(); ++r) {
 		if (r % 100000 == 0) {
 			checkProgress(r, papersAndAuthorsDB.size());
 		}
@@ -351,9 +353,9 @@ void dumpData(const std::string& inputFilePath) {
 	metadataFile << "{\n";
 	metadataFile << "  \"source_file\": \"" << inputFilePath << "\",\n";
 	metadataFile << "  \"source_file_last_write_time\": \"" << lwt << "\",\n";
-	metadataFile << "  \"total_papers\": " << papersToNumbers.getMaxID() - 1 << ",\n";
-	metadataFile << "  \"total_authors\": " << authorsToNumbers.getMaxID() - 1 << ",\n";
-	metadataFile << "  \"total_links\": " << papersAndAuthorsDB.size() - 1 << "\n";
+	metadataFile << "  \"total_papers\": " << papersToNumbers.getMaxID() << ",\n";
+	metadataFile << "  \"total_authors\": " << authorsToNumbers.getMaxID() << ",\n";
+	metadataFile << "  \"total_links\": " << papersAndAuthorsDB.size() << "\n";
 	metadataFile << "}\n";
 
 	// Close files
@@ -363,6 +365,72 @@ void dumpData(const std::string& inputFilePath) {
 	metadataFile.close();
 }
 
+void dumpCoauthors() {
+	// years indexed by paper ID, so the builder does not need to touch paperDB
+	std::vector<uint16_t> paperYears(papersToNumbers.getMaxID() + 1, 0);
+	for (uint32_t p = 1; p < paperYears.size(); ++p) {
+		paperYears[p] = paperDB.getItem(p).year;
+	}
+
+	auto numThreads = std::max(1u, std::thread::hardware_concurrency());
+	ThreadPool threadPool(numThreads);
+	CoauthorTableBuilder builder(papersAndAuthorsDB, paperYears, authorsToNumbers.getMaxID() + 1);
+	builder.build(threadPool, numThreads * 16);
+	builder.write("dblp_coauthors.bin");
+	std::cout << "Coauthor pairs: " << builder.numPairs() << std::endl;
+}
+
+// Arrow versions of the CSV tables, same columns and rows. ponder_dblp only writes them as IPC files,
+// exportArrowStream is there for code embedding these tables, not exposed by a library target.
+std::shared_ptr<const ArrowTable> buildPapersTable() {
+	auto table = std::make_shared<ArrowTable>(std::vector<ArrowField>{
+		{ "NumericID", "I" }, { "DBLP", "u" }, { "Title", "u" }, { "Type", "C" }, { "Year", "S" } });
+	for (uint32_t p = 1; p <= papersToNumbers.getMaxID(); ++p) {
+		auto paper = paperDB.getItem(p);
+		table->appendUInt32(p);
+		table->appendString(paper.id);
+		table->appendString(paper.title);
+		table->appendUInt8(paper.type);
+		table->appendUInt16(paper.year);
+		table->endRow();
+	}
+	return table;
+}
+
+std::shared_ptr<const ArrowTable> buildAuthorsTable() {
+	auto table = std::make_shared<ArrowTable>(std::vector<ArrowField>{
+		{ "NumericID", "I" }, { "DBLP", "u" }, { "Name", "u" }, { "ORCID", "u", true } });
+	for (uint32_t a = 1; a <= authorsToNumbers.getMaxID(); ++a) {
+		auto author = authorDB.getItem(a);
+		table->appendUInt32(a);
+		table->appendString(author.id);
+		table->appendString(author.name);
+		if (author.orcid.empty()) {
+			table->appendNull();
+		} else {
+			table->appendString(author.orcid);
+		}
+		table->endRow();
+	}
+	return table;
+}
+
+std::shared_ptr<const ArrowTable> buildPapersAuthorsTable() {
+	auto table = std::make_shared<ArrowTable>(std::vector<ArrowField>{ { "PaperID", "I" }, { "AuthorID", "I" } });
+	for (const auto& [paper, author] : papersAndAuthorsDB) {
+		table->appendUInt32(paper);
+		table->appendUInt32(author);
+		table->endRow();
+	}
+	return table;
+}
+
+void dumpArrow() {
+	writeArrowIPCFile(*buildPapersTable(), "dblp_papers.arrow");
+	writeArrowIPCFile(*buildAuthorsTable(), "dblp_authors.arrow");
+	writeArrowIPCFile(*buildPapersAuthorsTable(), "dblp_papers_authors.arrow");
+}
+
 void checkGZProgress(uint64_t lineCount, gzFile file, uint64_t total) {
 	if (lineCount % 1000000 == 0) {
 		auto pos = zng_gztell(file);
@@ -479,6 +547,14 @@ int main() {
 		}
 		std::cout << "saving CSVs..." << std::endl;
 		dumpData(inputFilePath);
+		{
+			Timer timer("Saving Arrow files...");
+			dumpArrow();
+		}
+		{
+			Timer timer("Building coauthor table...");
+			dumpCoauthors();
+		}
 	} catch (const std::exception& e) {
 		printError("Exception: " + std::string(e.what()));
 		removeLockFile(lockFilePath);
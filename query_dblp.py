@@ -9,12 +9,79 @@ from lxml import html
 import duckdb
 import uuid
 import json
+import mmap
+import os
+import struct
 from datetime import datetime
+try:
+    import pyarrow as pa
+except ImportError:
+    pa = None
 
 con = None
+coauthor_table = None
 init_notebook_mode(connected=True)
 
 
+class CoauthorTable:
+    """Memory-mapped dblp_coauthors.bin, see ponder_dblp/CoauthorTable.hpp for the layout."""
+    header = struct.Struct("<4sIIHHQQ")
+    offset_pair = struct.Struct("<QQ")
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        if len(self.data) < self.header.size:
+            raise ValueError(f"{path} is too small for a coauthor table")
+        magic, version, self.num_authors, self.base_year, _, self.num_entries, self.payload_size = self.header.unpack_from(self.data, 0)
+        if magic != b"QDCT" or version != 1:
+            raise ValueError(f"{path} is not a coauthor table or has an unsupported version")
+        self.payload_start = self.header.size + 8 * (self.num_authors + 1)
+        if len(self.data) < self.payload_start or self.payload_size > len(self.data) - self.payload_start:
+            raise ValueError(f"{path} is truncated")
+
+    def coauthors(self, author):
+        """(coauthor, first_year, last_year, papers) tuples of one author, sorted by coauthor."""
+        if not 0 <= author < self.num_authors:
+            return []
+        start, end = self.offset_pair.unpack_from(self.data, self.header.size + 8 * author)
+        if start > end or end > self.payload_size:
+            raise ValueError("Corrupt offsets in coauthor table")
+        values = []
+        value = shift = 0
+        for b in self.data[self.payload_start + start:self.payload_start + end]:
+            if shift == 28 and b > 0x0f:
+                raise ValueError("Corrupt varint in coauthor table")
+            value |= (b & 0x7f) << shift
+            if b & 0x80:
+                shift += 7
+            else:
+                values.append(value)
+                value = shift = 0
+        if shift or len(values) % 4:
+            raise ValueError("Corrupt varint in coauthor table")
+        result = []
+        coauthor = 0
+        for delta, last, span, count in zip(*[iter(values)] * 4):
+            coauthor += delta
+            last += self.base_year
+            result.append((coauthor, last - span, last, count + 1))
+        return result
+
+    def find_conflicts(self, author, sorted_candidates, min_year):
+        """Coauthors of author among sorted_candidates with a collaboration in min_year or later, by merging both sorted lists."""
+        result = []
+        i = 0
+        for entry in self.coauthors(author):
+            while i < len(sorted_candidates) and sorted_candidates[i] < entry[0]:
+                i += 1
+            if i == len(sorted_candidates):
+                break
+            if sorted_candidates[i] == entry[0] and entry[2] >= min_year:
+                result.append(entry)
+        return result
+
+
 def prepare_data(snapshot_dir):
     meta = json.loads(open(f"{snapshot_dir}/dblp_metadata.json").read())
     then = datetime.strptime(meta["source_file_last_write_time"][:26], "%Y-%m-%d %H:%M:%S.%f")
@@ -24,17 +91,56 @@ def prepare_data(snapshot_dir):
 
     global con
     con = duckdb.connect(database=':memory:', read_only=False)
-    con.execute(f"create table authors as select * from read_csv('{snapshot_dir}/dblp_authors.csv')")
-    con.execute(f"create table papers as select * from read_csv('{snapshot_dir}/dblp_papers.csv')")
-    con.execute(f"create table papers_authors as select * from read_csv('{snapshot_dir}/dblp_papers_authors.csv')")
+    for table in ["authors", "papers", "papers_authors"]:
+        arrow_file = f"{snapshot_dir}/dblp_{table}.arrow"
+        if pa is not None and os.path.exists(arrow_file):
+            # memory-mapped Arrow IPC file, DuckDB scans it in place without parsing
+            arrow_table = pa.ipc.open_file(pa.memory_map(arrow_file)).read_all()
+            con.register(f"{table}_arrow", arrow_table)
+            # the files use unsigned types, expose BIGINT like read_csv does so arithmetic cannot overflow
+            columns = ", ".join(f'cast("{f.name}" as bigint) as "{f.name}"' if pa.types.is_integer(f.type) else f'"{f.name}"'
+                                for f in arrow_table.schema)
+            con.execute(f"create view {table} as select {columns} from {table}_arrow")
+        else:
+            if os.path.exists(arrow_file):
+                print(f"Warning: pyarrow is not installed, parsing dblp_{table}.csv instead of using {arrow_file}.")
+            con.execute(f"create table {table} as select * from read_csv('{snapshot_dir}/dblp_{table}.csv')")
+
+    global coauthor_table
+    coauthor_file = f"{snapshot_dir}/dblp_coauthors.bin"
+    coauthor_table = CoauthorTable(coauthor_file) if os.path.exists(coauthor_file) else None
 
     con.execute("prepare find_author as select * from authors where starts_with(upper(Name), upper($name))")
     con.execute("prepare find_author_like as select * from authors where Name ilike $name")
     con.execute("prepare find_author_dblp as select * from authors where DBLP = $dblp")
-    con.execute("prepare find_coauthors as select * from papers_authors join papers on papers_authors.PaperID = papers.NumericID join authors on papers_authors.AuthorID = authors.NumericID where AuthorID in $list and Year >= $year")
+    # fallback for find_coauthors when there is no coauthor table
+    con.execute("prepare find_coauthor_pairs as select pa1.AuthorID, pa2.AuthorID as CoauthorID, min(Year) as FirstYear, max(Year) as LastYear, count(distinct pa1.PaperID) as Papers from papers_authors pa1 join papers_authors pa2 on pa1.PaperID = pa2.PaperID and pa1.AuthorID <> pa2.AuthorID join papers on pa1.PaperID = papers.NumericID where pa1.AuthorID in $list group by all having max(Year) >= $year")
     con.execute("prepare find_copapers as select * from papers_authors join papers on papers_authors.PaperID = papers.NumericID join authors on papers_authors.AuthorID = authors.NumericID where PaperID in (select PaperID from papers_authors where AuthorID in $list) and Year >= $year")
 
 
+def find_coauthors(author_ids, year):
+    """One row per (author, coauthor) pair with a collaboration in year or later, plus the coauthor's details."""
+    if coauthor_table is not None:
+        rows = [(a, c, first, last, papers) for a in map(int, author_ids)
+                for c, first, last, papers in coauthor_table.coauthors(a) if last >= year]
+        pairs = pd.DataFrame(rows, columns=["AuthorID", "CoauthorID", "FirstYear", "LastYear", "Papers"])
+    else:
+        pairs = con.execute(f"execute find_coauthor_pairs(list:={[int(a) for a in author_ids]}, year:={year})").df()
+    con.register("coauthor_pairs", pairs)
+    return con.execute("select coauthor_pairs.*, Name, DBLP, ORCID from coauthor_pairs join authors on CoauthorID = authors.NumericID order by AuthorID, CoauthorID").df()
+
+
+def find_conflicts(author_ids, candidate_ids, year):
+    """Pairs of author_ids (e.g. PC members) and candidate_ids (e.g. submission authors) that collaborated in year or later."""
+    if coauthor_table is None:
+        pairs = con.execute(f"execute find_coauthor_pairs(list:={[int(a) for a in author_ids]}, year:={year})").df()
+        return pairs[pairs["CoauthorID"].isin(candidate_ids)].sort_values(["AuthorID", "CoauthorID"]).reset_index(drop=True)
+    candidates = sorted(set(map(int, candidate_ids)))
+    rows = [(a, c, first, last, papers) for a in map(int, author_ids)
+            for c, first, last, papers in coauthor_table.find_conflicts(a, candidates, year)]
+    return pd.DataFrame(rows, columns=["AuthorID", "CoauthorID", "FirstYear", "LastYear", "Papers"])
+
+
 def show_search_UI():
     search = ""
     result = ""